@@ -69,6 +69,19 @@ BOOST_AUTO_TEST_CASE(attribute_cast_special) {
   BOOST_CHECK_EQUAL(d2, 22.22);
 }
 
+BOOST_AUTO_TEST_CASE(attribute_cast_special_on_error) {
+  namespace qi = boost::spirit::qi;
+
+  auto node = top_node->first_node("special");
+
+  qi::rule<const char*> rule = qi::double_ >> ";" >> qi::double_;
+  bool error_called = false;
+
+  rapidxml::attribute_cast_special(node, "special_map", rule, [&](){ error_called = true; });
+
+  BOOST_CHECK(error_called);
+}
+
 
 
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
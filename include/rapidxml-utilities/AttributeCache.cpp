@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <rapidxml/rapidxml.hpp>
+#include <BulkFileReader/BulkFileReader.h>
+#include <rapidxml-utilities/AttributeCache.h>
+#include <rapidxml-utilities/ForEachNode.h>
+
+struct FixtureAttributeCache {
+  FixtureAttributeCache() 
+  {
+    input = ozp::bulk_read_file("test1.xml");
+    doc.parse<0>(input.get());
+    top_node = doc.first_node("rapidxmlutilities");
+  }
+
+  rapidxml::xml_node<>* top_node;
+  rapidxml::xml_document<> doc;
+  std::unique_ptr<char []> input;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE (AttributeCache, FixtureAttributeCache)
+
+BOOST_AUTO_TEST_CASE(attribute_cache_cast) {
+  rapidxml::attribute_cache<double> cache(doc);
+  auto node = top_node->first_node("test");
+
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "double"), 1.0);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "double"), 1.0);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "int"), -10.0);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "str", 2.0), 2.0);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "missing", 3.0), 3.0);
+  BOOST_CHECK_THROW(cache.attribute_cast(node, "str"), std::runtime_error);
+  BOOST_CHECK_THROW(cache.attribute_cast(node, "missing"), std::runtime_error);
+  // failed casts and missing attributes are cached too
+  BOOST_CHECK_EQUAL(cache.misses(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_cache_modified) {
+  rapidxml::attribute_cache<int> cache(doc, 4);
+  auto node = top_node->first_node("test");
+
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "int"), -10);
+  node->first_attribute("int")->value("7");
+  cache.invalidate();
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "int"), 7);
+
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "added", 0), 0);
+  node->append_attribute(doc.allocate_attribute("added", "5"));
+  cache.invalidate();
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, "added", 0), 5);
+  BOOST_CHECK_EQUAL(cache.misses(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_cache_reparse) {
+  rapidxml::attribute_cache<int> cache(doc);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(top_node->first_node("test"), "int"), -10);
+
+  char xml[] = "<rapidxmlutilities><test int=\"7\"/></rapidxmlutilities>";
+  doc.parse<0>(xml);
+  top_node = doc.first_node("rapidxmlutilities");
+  BOOST_CHECK_EQUAL(cache.attribute_cast(top_node->first_node("test"), "int"), 7);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_cache_clear_reparse) {
+  rapidxml::xml_document<> limit_doc;
+  rapidxml::attribute_cache<int> cache(limit_doc);
+  char xml[32];
+
+  std::strcpy(xml, "<r limit=\"10\"/>");
+  limit_doc.parse<0>(xml);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(limit_doc.first_node("r"), "limit"), 10);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(limit_doc.first_node("r"), "low", 0), 0);
+
+  // the re-parsed nodes reuse the addresses of the old ones
+  limit_doc.clear();
+  std::strcpy(xml, "<r limit=\"20\" low=\"1\"/>");
+  limit_doc.parse<0>(xml);
+  cache.invalidate();
+  BOOST_CHECK_EQUAL(cache.attribute_cast(limit_doc.first_node("r"), "limit"), 20);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(limit_doc.first_node("r"), "low", 0), 1);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_cache_eviction) {
+  rapidxml::attribute_cache<std::string> cache(doc, 4);
+  BOOST_CHECK_EQUAL(cache.capacity(), 4);
+
+  // one set of four ways, 3 nodes with 5 names each keep evicting each other
+  const char* names[] = {"double", "float", "int", "uint", "str"};
+  std::vector<rapidxml::xml_node<>*> nodes;
+  rapidxml::for_each_node(top_node, "test1", [&](rapidxml::xml_node<>* node){ nodes.push_back(node); });
+
+  for (size_t round = 0; round < 3; ++round) {
+    for (size_t n = 0; n < nodes.size(); ++n) {
+      for (size_t i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(cache.attribute_cast(nodes[n], names[i]), nodes[n]->first_attribute(names[i])->value());
+      }
+    }
+  }
+  // 15 keys visited in turn through a round robin set, every lookup misses
+  BOOST_REQUIRE_EQUAL(nodes.size(), 3);
+  BOOST_CHECK_EQUAL(cache.misses(), 3 * 15);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_cache_runtime_names) {
+  rapidxml::attribute_cache<int> cache(doc, 4);
+  auto node = top_node->first_node("test");
+
+  for (size_t i = 0; i < 3; ++i) {
+    std::string name = "missing" + std::to_string(i);
+    BOOST_CHECK_EQUAL(cache.attribute_cast(node, name.c_str(), 1), 1);
+  }
+  std::string name = "int";
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, name.c_str()), -10);
+  BOOST_CHECK_EQUAL(cache.attribute_cast(node, std::string("missing0").c_str(), 2), 2);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_cache_concurrent_reads) {
+  rapidxml::attribute_cache<int> cache(doc, 8);
+  rapidxml::attribute_cache<std::string> str_cache(doc, 8);
+  std::vector<rapidxml::xml_node<>*> nodes;
+  rapidxml::for_each_node(top_node, [&](rapidxml::xml_node<>* node){
+    if (node->first_attribute("int")) nodes.push_back(node);
+  });
+
+  std::vector<int> errors(4, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < errors.size(); ++t) {
+    threads.push_back(std::thread([&, t](){
+      for (size_t i = 0; i < 10000; ++i) {
+        auto node = nodes[(i + t) % nodes.size()];
+        if (cache.attribute_cast(node, "int") != -10) ++errors[t];
+        if (cache.attribute_cast(node, "uint") != 10) ++errors[t];
+        if (cache.attribute_cast(node, "missing", 3) != 3) ++errors[t];
+        if (str_cache.attribute_cast(node, "int") != "-10") ++errors[t];
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+
+  for (size_t t = 0; t < errors.size(); ++t) BOOST_CHECK_EQUAL(errors[t], 0);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_cache_benchmark) {
+  typedef std::chrono::high_resolution_clock clock;
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  const size_t repeat = 100000;
+  const char* names[] = {"double", "float", "int", "uint"};
+  std::vector<rapidxml::xml_node<>*> nodes;
+  rapidxml::for_each_node(top_node, "test1", [&](rapidxml::xml_node<>* node){ nodes.push_back(node); });
+  rapidxml::attribute_cache<double> cache(doc);
+
+  // uncached lookup at its cheapest
+  double sum_cast = 0.0;
+  auto start = clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    for (size_t n = 0; n < nodes.size(); ++n) {
+      for (size_t a = 0; a < 4; ++a) {
+        auto attribute = nodes[n]->first_attribute(names[a]);
+        double value = 0.0;
+        auto first = attribute->value();
+        rapidxml::detail::value_converter<double>::convert(first, first + attribute->value_size(), value);
+        sum_cast += value;
+      }
+    }
+  }
+  auto cast_time = clock::now() - start;
+
+  double sum_cache = 0.0;
+  start = clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    for (size_t n = 0; n < nodes.size(); ++n) {
+      for (size_t a = 0; a < 4; ++a) sum_cache += cache.attribute_cast(nodes[n], names[a]);
+    }
+  }
+  auto cache_time = clock::now() - start;
+
+  BOOST_CHECK_EQUAL(sum_cast, sum_cache);
+  BOOST_CHECK_EQUAL(cache.misses(), nodes.size() * 4);
+  BOOST_TEST_MESSAGE(repeat * nodes.size() * 4 << " lookups of " << nodes.size() * 4 << " attributes."
+    << " first_attribute and value_converter: " << duration_cast<microseconds>(cast_time).count() << " us"
+    << ", attribute_cache hits: " << duration_cast<microseconds>(cache_time).count() << " us.");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
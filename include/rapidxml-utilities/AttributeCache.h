@@ -0,0 +1,335 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <boost/type_traits/has_trivial_assign.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <rapidxml/rapidxml.hpp>
+#include "ValueConverter.h"
+
+namespace rapidxml {
+
+namespace detail {
+
+  // Converted value of a cache entry. Small trivially copyable values are atomic so readers can copy
+  // them while a writer changes the entry, other values are only copied when no writer is active.
+  template <typename T, bool LockFree = boost::has_trivial_copy<T>::value && boost::has_trivial_assign<T>::value
+    && boost::has_trivial_destructor<T>::value && sizeof(T) <= sizeof(unsigned long long)>
+  class cache_value
+  {
+  public:
+    static const bool lock_free = true;
+
+    cache_value() : value(T()) {}
+    void load(T& out) const { out = value.load(std::memory_order_relaxed); }
+    void store(const T& val) { value.store(val, std::memory_order_relaxed); }
+
+  private:
+    std::atomic<T> value;
+  };
+
+  template <typename T> class cache_value<T, false>
+  {
+  public:
+    static const bool lock_free = false;
+
+    cache_value() : value() {}
+    void load(T& out) const { out = value; }
+    void store(const T& val) { value = val; }
+
+  private:
+    T value;
+  };
+}
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /// <summary> Memoizes attribute values of a document converted to T, including failed lookups. </summary>
+  ///
+  /// <remarks> Entries are kept in a fixed size 4-way set associative table, a full set evicts
+  ///           round robin. Each set has a tag block of one cache line holding a version word and
+  ///           the node and name hash of its ways, converted values are stored apart from it. A hit
+  ///           probes the tag block and copies the value without touching the document.
+  ///
+  ///           Readers take no lock: numeric values are read optimistically and retried when the
+  ///           version word shows a concurrent writer, other types (e.g. std::string) register in
+  ///           the set while copying. Misses convert outside any lock and take a writer mutex only
+  ///           to store the result. Missing attributes and failed casts are cached the same way.
+  ///
+  ///           Entries belong to a generation of the cache. invalidate() starts a new one, as does
+  ///           parsing the document into new nodes. The cache does not look at the attributes on a
+  ///           hit, so call invalidate() after editing the document: changing, adding or removing
+  ///           attributes or nodes, or clear() and parse() into the same document, which may reuse
+  ///           the node addresses. Attribute names are copied once and kept until the cache is
+  ///           destroyed. </remarks>
+  ///
+  /// <typeparam name="T">  Type the attributes are converted to. </typeparam>
+  /// <typeparam name="Ch"> Type of the character rapidxml doc uses. </typeparam>
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  template <typename T, typename Ch = char> class attribute_cache
+  {
+  public:
+    explicit attribute_cache(const xml_document<Ch>& doc, std::size_t capacity = 1024)
+      : doc(doc), set_count(1), generation(0), miss_count(0)
+    {
+      while (set_count * ways < capacity) set_count *= 2;
+      tag_storage.reset(new unsigned char[(set_count + 1) * cache_line]);
+      auto address = reinterpret_cast<std::size_t>(tag_storage.get());
+      tags = reinterpret_cast<unsigned char*>((address + cache_line - 1) & ~(cache_line - 1));
+      for (std::size_t set = 0; set < set_count; ++set) new (tags + set * cache_line) set_tags();
+      entries.reset(new entry[set_count * ways]);
+      victims.resize(set_count, 0);
+      snapshot();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// <summary> Casts attribute value to T. Throws error if the attribute is missing or casting fails. </summary>
+    ///
+    /// <param name="node">      If non-null, the node. </param>
+    /// <param name="attr_name"> Name of the attribute. </param>
+    ///
+    /// <returns> The cast value of attribute. </returns>
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    T attribute_cast(const xml_node<Ch>* node, const Ch* attr_name)
+    {
+      if (! node) throw std::runtime_error("node does not exists.");
+      T val;
+      switch (lookup(node, attr_name, val)) {
+        case status_missing: throw std::runtime_error("attribute does not exists.");
+        case status_bad_cast: throw std::runtime_error("cast failed.");
+        default: return val;
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// <summary> Casts attribute value to T. Return default value if the attribute is missing or
+    ///           casting fails. </summary>
+    ///
+    /// <param name="node">          If non-null, the node. </param>
+    /// <param name="attr_name">     Name of the attribute. </param>
+    /// <param name="default_value"> The default value. </param>
+    ///
+    /// <returns> The cast value of attribute. </returns>
+    ////////////////////////////////////////////////////////////////////////////////////////////////////
+    T attribute_cast(const xml_node<Ch>* node, const Ch* attr_name, T default_value)
+    {
+      if (! node) return default_value;
+      T val;
+      return (lookup(node, attr_name, val) == status_ok) ? val : default_value;
+    }
+
+    /// <summary> Drops all entries. Needed after the document is edited. </summary>
+    void invalidate()
+    {
+      std::lock_guard<std::mutex> lock(writer);
+      generation.fetch_add(1);
+      snapshot();
+    }
+
+    std::size_t capacity() const { return set_count * ways; }
+
+    /// <summary> Number of lookups that had to find and convert the attribute. </summary>
+    std::size_t misses() const { return miss_count.load(std::memory_order_relaxed); }
+
+  private:
+    attribute_cache(const attribute_cache&);
+    attribute_cache& operator=(const attribute_cache&);
+
+    static const std::size_t ways = 4;
+    static const std::size_t cache_line = 64;
+    enum status_type { status_ok, status_missing, status_bad_cast };
+    typedef std::basic_string<Ch> name_type;
+    typedef detail::cache_value<T> value_type;
+
+    // Probed on every lookup, one cache line per set.
+    struct set_tags {
+      set_tags() : version(0), readers(0), generation(0)
+      {
+        for (std::size_t way = 0; way < ways; ++way) {
+          hash[way].store(0, std::memory_order_relaxed);
+          node[way].store(nullptr, std::memory_order_relaxed);
+        }
+      }
+
+      std::atomic<unsigned> version; // odd while a writer changes the set
+      std::atomic<unsigned> readers; // readers copying values that are not lock free
+      std::atomic<unsigned> generation; // ways of an older generation are empty
+      std::atomic<unsigned> hash[ways]; // hash of the attribute name
+      std::atomic<const xml_node<Ch>*> node[ways]; // nullptr for an empty way
+    };
+    static_assert(sizeof(set_tags) <= cache_line, "set tags must fit a cache line");
+
+    struct entry {
+      entry() : name(nullptr), status(status_missing) {}
+
+      std::atomic<const name_type*> name; // owned by names
+      std::atomic<int> status;
+      value_type value;
+    };
+
+    status_type lookup(const xml_node<Ch>* node, const Ch* attr_name, T& out)
+    {
+      std::size_t name_size = 0;
+      unsigned name_hash = 2166136261u;
+      for (auto ch = attr_name; *ch != Ch(0); ++ch, ++name_size) {
+        name_hash = (name_hash ^ static_cast<unsigned>(*ch)) * 16777619u;
+      }
+      auto mix = (reinterpret_cast<std::size_t>(node) >> 4) * 2654435761u ^ name_hash;
+      std::size_t set = ((mix >> 16) ^ mix) & (set_count - 1);
+
+      if (! is_current()) renew();
+      unsigned current = generation.load();
+      status_type status = status_missing;
+      if (find(set, node, name_hash, attr_name, name_size, current, out, status)) return status;
+      return insert(set, node, name_hash, attr_name, name_size, current, out);
+    }
+
+    bool find(std::size_t set, const xml_node<Ch>* node, unsigned name_hash, const Ch* attr_name,
+      std::size_t name_size, unsigned current, T& out, status_type& status) const
+    {
+      auto& tag = tags_of(set);
+      for (;;) {
+        if (! value_type::lock_free) tag.readers.fetch_add(1);
+        unsigned version = tag.version.load();
+        if (version & 1) {
+          if (! value_type::lock_free) tag.readers.fetch_sub(1, std::memory_order_release);
+          std::this_thread::yield();
+          continue;
+        }
+
+        const name_type* name = nullptr;
+        if (tag.generation.load(std::memory_order_relaxed) == current) {
+          for (std::size_t way = 0; way < ways; ++way) {
+            if (tag.node[way].load(std::memory_order_relaxed) == node &&
+              tag.hash[way].load(std::memory_order_relaxed) == name_hash) {
+              auto& e = entries[set * ways + way];
+              name = e.name.load(std::memory_order_relaxed);
+              status = static_cast<status_type>(e.status.load(std::memory_order_relaxed));
+              e.value.load(out);
+              break;
+            }
+          }
+        }
+
+        if (value_type::lock_free) {
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (tag.version.load(std::memory_order_relaxed) != version) continue;
+        } else {
+          tag.readers.fetch_sub(1, std::memory_order_release);
+        }
+        // names are never changed or freed, equal hashes may still be different names
+        return name && name->size() == name_size &&
+          std::char_traits<Ch>::compare(name->data(), attr_name, name_size) == 0;
+      }
+    }
+
+    status_type insert(std::size_t set, const xml_node<Ch>* node, unsigned name_hash, const Ch* attr_name,
+      std::size_t name_size, unsigned current, T& out)
+    {
+      miss_count.fetch_add(1, std::memory_order_relaxed);
+      T converted = T();
+      status_type status = status_missing;
+      auto attribute = node->first_attribute(attr_name, name_size);
+      if (attribute) {
+        auto first = attribute->value();
+        status = detail::value_converter<T>::convert(first, first + attribute->value_size(), converted)
+          ? status_ok : status_bad_cast;
+      }
+      out = converted;
+
+      std::lock_guard<std::mutex> lock(writer);
+      if (generation.load() != current) return status; // invalidated while converting
+      const name_type* name = &*names.insert(name_type(attr_name, name_size)).first;
+
+      auto& tag = tags_of(set);
+      begin_write(tag);
+      if (tag.generation.load(std::memory_order_relaxed) != current) {
+        for (std::size_t way = 0; way < ways; ++way) tag.node[way].store(nullptr, std::memory_order_relaxed);
+        tag.generation.store(current, std::memory_order_relaxed);
+        victims[set] = 0;
+      }
+      auto way = victim(set, node, name);
+      auto& e = entries[set * ways + way];
+      tag.node[way].store(node, std::memory_order_relaxed);
+      tag.hash[way].store(name_hash, std::memory_order_relaxed);
+      e.name.store(name, std::memory_order_relaxed);
+      e.status.store(status, std::memory_order_relaxed);
+      e.value.store(converted);
+      tag.version.fetch_add(1, std::memory_order_release);
+      return status;
+    }
+
+    // way of the same key stored by a concurrent miss, an empty way or the next one round robin
+    std::size_t victim(std::size_t set, const xml_node<Ch>* node, const name_type* name)
+    {
+      auto& tag = tags_of(set);
+      for (std::size_t way = 0; way < ways; ++way) {
+        if (tag.node[way].load(std::memory_order_relaxed) == node &&
+          entries[set * ways + way].name.load(std::memory_order_relaxed) == name) return way;
+      }
+      for (std::size_t way = 0; way < ways; ++way) {
+        if (! tag.node[way].load(std::memory_order_relaxed)) return way;
+      }
+      auto way = victims[set];
+      victims[set] = static_cast<unsigned char>((way + 1) % ways);
+      return way;
+    }
+
+    // makes the version odd and waits for readers that copy values under a reader count
+    void begin_write(set_tags& tag)
+    {
+      tag.version.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_release);
+      if (! value_type::lock_free) {
+        while (tag.readers.load() != 0) std::this_thread::yield();
+      }
+    }
+
+    set_tags& tags_of(std::size_t set) const { return *reinterpret_cast<set_tags*>(tags + set * cache_line); }
+
+    // a document parsed into new nodes starts a new generation
+    bool is_current() const
+    {
+      auto first = doc.first_node();
+      return first == doc_first.load(std::memory_order_relaxed) &&
+        (! first || doc.last_node() == doc_last.load(std::memory_order_relaxed));
+    }
+
+    void renew()
+    {
+      std::lock_guard<std::mutex> lock(writer);
+      if (is_current()) return;
+      generation.fetch_add(1);
+      snapshot();
+    }
+
+    void snapshot()
+    {
+      auto first = doc.first_node();
+      doc_first.store(first, std::memory_order_relaxed);
+      doc_last.store(first ? doc.last_node() : nullptr, std::memory_order_relaxed);
+    }
+
+    const xml_document<Ch>& doc;
+    std::size_t set_count;
+    std::unique_ptr<unsigned char[]> tag_storage;
+    unsigned char* tags; // set_tags aligned to cache lines
+    std::unique_ptr<entry[]> entries;
+    std::atomic<unsigned> generation;
+    std::atomic<std::size_t> miss_count;
+    std::atomic<const xml_node<Ch>*> doc_first;
+    std::atomic<const xml_node<Ch>*> doc_last;
+    // written under writer only
+    std::mutex writer;
+    std::vector<unsigned char> victims;
+    std::set<name_type> names;
+  };
+
+}
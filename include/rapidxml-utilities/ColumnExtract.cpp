@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <rapidxml/rapidxml.hpp>
+#include <BulkFileReader/BulkFileReader.h>
+#include <rapidxml-utilities/ColumnExtract.h>
+
+struct FixtureColumnExtract {
+  FixtureColumnExtract() 
+  {
+    input = ozp::bulk_read_file("test1.xml");
+    doc.parse<0>(input.get());
+    top_node = doc.first_node("rapidxmlutilities");
+  }
+
+  rapidxml::xml_node<>* top_node;
+  rapidxml::xml_document<> doc;
+  std::unique_ptr<char []> input;
+};
+
+// per element extraction the way it is done without extract_columns
+template <typename T> void append_attribute
+  (const rapidxml::xml_node<>* node, const char* name, std::vector<T>& values, std::vector<bool>& valid)
+{
+  auto attribute = node->first_attribute(name);
+  T value;
+  bool success = attribute &&
+    rapidxml::detail::value_converter<T>::convert(attribute->value(), attribute->value() + attribute->value_size(), value);
+  values.push_back(success ? value : T());
+  valid.push_back(success);
+}
+
+
+BOOST_FIXTURE_TEST_SUITE (ColumnExtract, FixtureColumnExtract)
+
+BOOST_AUTO_TEST_CASE(extract_columns_all) {
+  rapidxml::attribute_column<double> doubles("double");
+  rapidxml::attribute_column<int> ints("int");
+  rapidxml::attribute_column<unsigned> uints("uint");
+  rapidxml::attribute_column<std::string> strs("str");
+
+  auto count = rapidxml::extract_columns(top_node, "test1", doubles, ints, uints, strs);
+
+  BOOST_CHECK_EQUAL(count, 3);
+  BOOST_CHECK_EQUAL(doubles.values.size(), 3);
+  BOOST_CHECK_EQUAL(doubles.values[2], 1.0);
+  BOOST_CHECK_EQUAL(ints.values[0], -10);
+  BOOST_CHECK_EQUAL(uints.values[1], 10);
+  BOOST_CHECK_EQUAL(strs.values[2], "test");
+  BOOST_CHECK(ints.valid[0] && ints.valid[1] && ints.valid[2]);
+}
+
+BOOST_AUTO_TEST_CASE(extract_columns_invalid) {
+  rapidxml::attribute_column<double> strs_as_double("str", -1.0);
+  rapidxml::attribute_column<int> missing("missing", 5);
+
+  rapidxml::extract_columns(top_node, "test1", strs_as_double, missing);
+
+  BOOST_CHECK_EQUAL(strs_as_double.values[0], -1.0);
+  BOOST_CHECK(! strs_as_double.valid[0]);
+  BOOST_CHECK_EQUAL(missing.values[1], 5);
+  BOOST_CHECK(! missing.valid[1]);
+}
+
+BOOST_AUTO_TEST_CASE(extract_columns_attribute_order) {
+  char xml[] = "<r><e a=\"1\" b=\"2\"/><e b=\"4\" a=\"3\"/><e b=\"6\"/><e c=\"0\" a=\"7\" b=\"8\"/></r>";
+  rapidxml::xml_document<> order_doc;
+  order_doc.parse<0>(xml);
+
+  rapidxml::attribute_column<int> a("a", -1);
+  rapidxml::attribute_column<int> b("b", -1);
+  rapidxml::extract_columns(order_doc.first_node("r"), "e", a, b);
+
+  int expected_a[] = {1, 3, -1, 7};
+  int expected_b[] = {2, 4, 6, 8};
+  BOOST_CHECK_EQUAL_COLLECTIONS(a.values.begin(), a.values.end(), expected_a, expected_a + 4);
+  BOOST_CHECK_EQUAL_COLLECTIONS(b.values.begin(), b.values.end(), expected_b, expected_b + 4);
+  BOOST_CHECK(a.valid[1] && ! a.valid[2] && a.valid[3]);
+}
+
+BOOST_AUTO_TEST_CASE(extract_columns_many_elements) {
+  const int element_count = 600;
+  std::string str = "<r>";
+  for (int i = 0; i < element_count; ++i) {
+    str += (i % 7 == 0) ? "<e b=\"x\" a=\"" + std::to_string(i) + "\"/>"
+                        : "<e a=\"" + std::to_string(i) + "\" b=\"2.5\"/>";
+  }
+  str += "</r>";
+  std::vector<char> xml(str.begin(), str.end());
+  xml.push_back(0);
+  rapidxml::xml_document<> many_doc;
+  many_doc.parse<0>(xml.data());
+
+  rapidxml::attribute_column<int> a("a");
+  rapidxml::attribute_column<double> b("b");
+  auto count = rapidxml::extract_columns(many_doc.first_node("r"), "e", a, b);
+
+  BOOST_REQUIRE_EQUAL(count, element_count);
+  BOOST_REQUIRE_EQUAL(a.values.size(), element_count);
+  BOOST_REQUIRE_EQUAL(b.valid.size(), element_count);
+  for (int i = 0; i < element_count; ++i) {
+    BOOST_CHECK_EQUAL(a.values[i], i);
+    BOOST_CHECK_EQUAL(b.valid[i], i % 7 != 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(extract_columns_benchmark) {
+  typedef std::chrono::high_resolution_clock clock;
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  const int element_count = 200000;
+  const int repeat = 5;
+  std::string str = "<r>";
+  for (int i = 0; i < element_count; ++i) {
+    str += "<e double=\"1.5\" float=\"2.5\" int=\"-" + std::to_string(i) + "\" uint=\"10\" str=\"test\"/>";
+  }
+  str += "</r>";
+  std::vector<char> xml(str.begin(), str.end());
+  xml.push_back(0);
+  rapidxml::xml_document<> bench_doc;
+  bench_doc.parse<0>(xml.data());
+  auto parent = bench_doc.first_node("r");
+
+  clock::duration column_time = clock::duration::max();
+  clock::duration element_time = clock::duration::max();
+  for (int r = 0; r < repeat; ++r) {
+    auto start = clock::now();
+    rapidxml::attribute_column<double> doubles("double");
+    rapidxml::attribute_column<float> floats("float");
+    rapidxml::attribute_column<int> ints("int");
+    rapidxml::attribute_column<unsigned> uints("uint");
+    rapidxml::extract_columns(parent, "e", doubles, floats, ints, uints);
+    column_time = std::min(column_time, clock::now() - start);
+
+    start = clock::now();
+    std::vector<double> element_doubles;
+    std::vector<float> element_floats;
+    std::vector<int> element_ints;
+    std::vector<unsigned> element_uints;
+    std::vector<bool> valid[4];
+    for (auto node = parent->first_node("e"); node != nullptr; node = node->next_sibling("e")) {
+      append_attribute(node, "double", element_doubles, valid[0]);
+      append_attribute(node, "float", element_floats, valid[1]);
+      append_attribute(node, "int", element_ints, valid[2]);
+      append_attribute(node, "uint", element_uints, valid[3]);
+    }
+    element_time = std::min(element_time, clock::now() - start);
+
+    BOOST_CHECK(ints.values == element_ints);
+    BOOST_CHECK(uints.valid == valid[3]);
+  }
+
+  BOOST_TEST_MESSAGE(element_count << " elements, 4 numeric columns, best of " << repeat << "."
+    << " extract_columns: " << duration_cast<microseconds>(column_time).count() << " us"
+    << ", first_attribute and value_converter per element: " << duration_cast<microseconds>(element_time).count() << " us.");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
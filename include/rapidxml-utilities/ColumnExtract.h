@@ -0,0 +1,233 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include <rapidxml/rapidxml.hpp>
+#include "ValueConverter.h"
+
+namespace rapidxml {
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /// <summary> A typed column filled by extract_columns. </summary>
+  ///
+  /// <remarks> values and valid are appended to, one entry per extracted element. valid is the
+  ///           validity bitmap of the column: false when the attribute is missing or can not be
+  ///           converted, in which case the value is default_value. </remarks>
+  ///
+  /// <typeparam name="T">  Type of the column values. </typeparam>
+  /// <typeparam name="Ch"> Type of the character rapidxml doc uses. </typeparam>
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  template <typename T, typename Ch = char> class attribute_column
+  {
+  public:
+    typedef T value_type;
+
+    explicit attribute_column(const Ch* attr_name, T default_value = T())
+      : name(attr_name), name_size(internal::measure(attr_name)), default_value(std::move(default_value)) {}
+
+    const Ch* name;
+    std::size_t name_size;
+    T default_value;
+    std::vector<T> values;
+    std::vector<bool> valid;
+  };
+
+namespace detail {
+
+  const std::size_t column_no_slot = std::size_t(-1);
+  const std::size_t column_max = 6; // columns of the largest extract_columns overload
+
+  // Type erased access to an attribute_column.
+  template <typename Ch> class column_adapter
+  {
+  public:
+    virtual ~column_adapter() {}
+    virtual const Ch* name() const = 0;
+    virtual std::size_t name_size() const = 0;
+    virtual void append(const xml_attribute<Ch>* attribute) = 0; // nullptr if missing
+  };
+
+  template <typename T, typename Ch> class typed_column_adapter : public column_adapter<Ch>
+  {
+  public:
+    explicit typed_column_adapter(attribute_column<T, Ch>& column) : column(column) {}
+
+    const Ch* name() const { return column.name; }
+    std::size_t name_size() const { return column.name_size; }
+
+    void append(const xml_attribute<Ch>* attribute)
+    {
+      T value;
+      bool valid = attribute &&
+        value_converter<T>::convert(attribute->value(), attribute->value() + attribute->value_size(), value);
+      column.values.push_back(valid ? value : column.default_value);
+      column.valid.push_back(valid);
+    }
+
+  private:
+    typed_column_adapter& operator=(const typed_column_adapter&);
+
+    attribute_column<T, Ch>& column;
+  };
+
+  template <typename Ch> bool attribute_name_is
+    (const xml_attribute<Ch>* attribute, const Ch* name, std::size_t name_size)
+  {
+    return attribute->name_size() == name_size && std::char_traits<Ch>::compare(attribute->name(), name, name_size) == 0;
+  }
+
+  template <typename NodeType, typename Ch> std::size_t extract_column_list
+    (NodeType* parent, const Ch* child_name, column_adapter<Ch>* const* columns, std::size_t column_count)
+  {
+    auto node = parent ? parent->first_node(child_name) : nullptr;
+    if (! node) return 0;
+
+    const Ch* names[column_max];
+    std::size_t name_sizes[column_max];
+    for (std::size_t c = 0; c < column_count; ++c) {
+      names[c] = columns[c]->name();
+      name_sizes[c] = columns[c]->name_size();
+    }
+
+    // column expected at each attribute position, learned from the first element
+    std::vector<std::size_t> slot_columns;
+    unsigned learned = 0;
+    for (auto attribute = node->first_attribute(); attribute != nullptr; attribute = attribute->next_attribute()) {
+      slot_columns.push_back(column_no_slot);
+      for (std::size_t c = 0; c < column_count; ++c) {
+        if (! (learned & (1u << c)) && attribute_name_is(attribute, names[c], name_sizes[c])) {
+          slot_columns.back() = c;
+          learned |= 1u << c;
+          break;
+        }
+      }
+    }
+
+    const unsigned all = (1u << column_count) - 1;
+    const std::size_t slot_count = slot_columns.size();
+    std::size_t count = 0;
+    for (; node != nullptr; node = node->next_sibling(child_name), ++count) {
+      unsigned matched = 0;
+      std::size_t slot = 0;
+      for (auto attribute = node->first_attribute(); attribute != nullptr && slot < slot_count;
+        attribute = attribute->next_attribute(), ++slot) {
+          auto c = slot_columns[slot];
+          if (c != column_no_slot && attribute_name_is(attribute, names[c], name_sizes[c])) {
+            columns[c]->append(attribute);
+            matched |= 1u << c;
+          }
+      }
+      if (matched == all) continue;
+
+      // slow path: the attribute is not where it was on the first element
+      for (std::size_t c = 0; c < column_count; ++c) {
+        if (! (matched & (1u << c))) columns[c]->append(node->first_attribute(names[c], name_sizes[c]));
+      }
+    }
+    return count;
+  }
+}
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /// <summary> Extracts attributes of each child node matching name into typed columns. </summary>
+  ///
+  /// <remarks> Attribute positions are learned from the first matching child. The attribute list
+  ///           of each child is walked once, comparing each attribute only with the name of the
+  ///           column learned for its position, and values are converted as they are found.
+  ///           Columns not found that way are searched by name. Supported column types are
+  ///           double, float, int, unsigned, unsigned long, unsigned long long and strings.
+  ///           String values are stored untrimmed. Overloads take one to six columns. </remarks>
+  ///
+  /// <typeparam name="NodeType"> Type of the node type. </typeparam>
+  /// <typeparam name="Ch">       Type of the character rapidxml doc uses. </typeparam>
+  /// <typeparam name="T1">       Value type of the first column. </typeparam>
+  /// <param name="parent">     [in,out] Parent node. </param>
+  /// <param name="child_name"> Name of the child nodes. </param>
+  /// <param name="c1">         [in,out] Column to append extracted values to. </param>
+  ///
+  /// <returns> Number of child nodes extracted. </returns>
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  template <typename NodeType, typename Ch, typename T1> std::size_t extract_columns
+    (NodeType* parent, const Ch* child_name, attribute_column<T1, Ch>& c1)
+  {
+    detail::typed_column_adapter<T1, Ch> a1(c1);
+    detail::column_adapter<Ch>* columns[] = {&a1};
+    return detail::extract_column_list(parent, child_name, columns, 1);
+  }
+
+  template <typename NodeType, typename Ch, typename T1, typename T2> std::size_t extract_columns
+    (NodeType* parent, const Ch* child_name, attribute_column<T1, Ch>& c1, attribute_column<T2, Ch>& c2)
+  {
+    detail::typed_column_adapter<T1, Ch> a1(c1);
+    detail::typed_column_adapter<T2, Ch> a2(c2);
+    detail::column_adapter<Ch>* columns[] = {&a1, &a2};
+    return detail::extract_column_list(parent, child_name, columns, 2);
+  }
+
+  template <typename NodeType, typename Ch, typename T1, typename T2, typename T3> std::size_t extract_columns
+    (NodeType* parent, const Ch* child_name,
+     attribute_column<T1, Ch>& c1,
+     attribute_column<T2, Ch>& c2,
+     attribute_column<T3, Ch>& c3)
+  {
+    detail::typed_column_adapter<T1, Ch> a1(c1);
+    detail::typed_column_adapter<T2, Ch> a2(c2);
+    detail::typed_column_adapter<T3, Ch> a3(c3);
+    detail::column_adapter<Ch>* columns[] = {&a1, &a2, &a3};
+    return detail::extract_column_list(parent, child_name, columns, 3);
+  }
+
+  template <typename NodeType, typename Ch, typename T1, typename T2, typename T3, typename T4> std::size_t extract_columns
+    (NodeType* parent, const Ch* child_name,
+     attribute_column<T1, Ch>& c1,
+     attribute_column<T2, Ch>& c2,
+     attribute_column<T3, Ch>& c3,
+     attribute_column<T4, Ch>& c4)
+  {
+    detail::typed_column_adapter<T1, Ch> a1(c1);
+    detail::typed_column_adapter<T2, Ch> a2(c2);
+    detail::typed_column_adapter<T3, Ch> a3(c3);
+    detail::typed_column_adapter<T4, Ch> a4(c4);
+    detail::column_adapter<Ch>* columns[] = {&a1, &a2, &a3, &a4};
+    return detail::extract_column_list(parent, child_name, columns, 4);
+  }
+
+  template <typename NodeType, typename Ch, typename T1, typename T2, typename T3, typename T4, typename T5> std::size_t extract_columns
+    (NodeType* parent, const Ch* child_name,
+     attribute_column<T1, Ch>& c1,
+     attribute_column<T2, Ch>& c2,
+     attribute_column<T3, Ch>& c3,
+     attribute_column<T4, Ch>& c4,
+     attribute_column<T5, Ch>& c5)
+  {
+    detail::typed_column_adapter<T1, Ch> a1(c1);
+    detail::typed_column_adapter<T2, Ch> a2(c2);
+    detail::typed_column_adapter<T3, Ch> a3(c3);
+    detail::typed_column_adapter<T4, Ch> a4(c4);
+    detail::typed_column_adapter<T5, Ch> a5(c5);
+    detail::column_adapter<Ch>* columns[] = {&a1, &a2, &a3, &a4, &a5};
+    return detail::extract_column_list(parent, child_name, columns, 5);
+  }
+
+  template <typename NodeType, typename Ch, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6> std::size_t extract_columns
+    (NodeType* parent, const Ch* child_name,
+     attribute_column<T1, Ch>& c1,
+     attribute_column<T2, Ch>& c2,
+     attribute_column<T3, Ch>& c3,
+     attribute_column<T4, Ch>& c4,
+     attribute_column<T5, Ch>& c5,
+     attribute_column<T6, Ch>& c6)
+  {
+    detail::typed_column_adapter<T1, Ch> a1(c1);
+    detail::typed_column_adapter<T2, Ch> a2(c2);
+    detail::typed_column_adapter<T3, Ch> a3(c3);
+    detail::typed_column_adapter<T4, Ch> a4(c4);
+    detail::typed_column_adapter<T5, Ch> a5(c5);
+    detail::typed_column_adapter<T6, Ch> a6(c6);
+    detail::column_adapter<Ch>* columns[] = {&a1, &a2, &a3, &a4, &a5, &a6};
+    return detail::extract_column_list(parent, child_name, columns, 6);
+  }
+
+}
@@ -0,0 +1,180 @@
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <boost/spirit/include/qi.hpp>
+#include <boost/spirit/include/phoenix_core.hpp>
+#include <boost/spirit/include/phoenix_operator.hpp>
+#include <rapidxml/rapidxml.hpp>
+#include <BulkFileReader/BulkFileReader.h>
+#include <rapidxml-utilities/KeyValueList.h>
+
+struct FixtureKeyValueList {
+  FixtureKeyValueList()
+  {
+    input = ozp::bulk_read_file("test1.xml");
+    doc.parse<0>(input.get());
+    top_node = doc.first_node("rapidxmlutilities");
+  }
+
+  rapidxml::xml_node<>* top_node;
+  rapidxml::xml_document<> doc;
+  std::unique_ptr<char []> input;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE (KeyValueList, FixtureKeyValueList)
+
+BOOST_AUTO_TEST_CASE(attribute_key_values_storage) {
+  auto node = top_node->first_node("special");
+
+  rapidxml::key_value<double> pairs[4];
+  auto count = rapidxml::attribute_key_values(node, "special_map", pairs, 4);
+
+  BOOST_CHECK_EQUAL(count, 2);
+  BOOST_CHECK_EQUAL(pairs[0].key, "me");
+  BOOST_CHECK_EQUAL(pairs[0].value, 11.11);
+  BOOST_CHECK_EQUAL(pairs[1].key, "you");
+  BOOST_CHECK_EQUAL(pairs[1].value, 22.22);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_key_values_errors) {
+  auto node = top_node->first_node("special");
+
+  rapidxml::key_value<double> pairs[1];
+  BOOST_CHECK_THROW(rapidxml::attribute_key_values(node, "special_map", pairs, 1), std::runtime_error);
+  BOOST_CHECK_THROW(rapidxml::attribute_key_values(node, "special_vals", pairs, 1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(attribute_key_values_overflow) {
+  char xml[] = "<e map=\"a=1;b=2;c=x\"/>";
+  rapidxml::xml_document<> overflow_doc;
+  overflow_doc.parse<0>(xml);
+
+  // decoding stops at b, c would fail to cast
+  rapidxml::key_value<int> pairs[1];
+  std::string message;
+  try {
+    rapidxml::attribute_key_values(overflow_doc.first_node("e"), "map", pairs, 1);
+  } catch (const std::runtime_error& e) {
+    message = e.what();
+  }
+  BOOST_CHECK_EQUAL(message, "not enough storage.");
+  BOOST_CHECK_EQUAL(pairs[0].value, 1);
+}
+
+BOOST_AUTO_TEST_CASE(for_each_key_value_stop) {
+  const std::string str = "a=1;b=2;c=x";
+  int calls = 0;
+
+  bool success = rapidxml::for_each_key_value<int>(str.data(), str.data() + str.size(),
+    [&](boost::string_ref, int) -> bool { return ++calls < 2; });
+
+  BOOST_CHECK(success);
+  BOOST_CHECK_EQUAL(calls, 2);
+}
+
+BOOST_AUTO_TEST_CASE(for_each_key_value_separators) {
+  const std::string str = " a : 1 , b:-2,";
+  std::vector<std::pair<std::string, int>> pairs;
+
+  bool success = rapidxml::for_each_key_value<int>(str.data(), str.data() + str.size(),
+    [&](boost::string_ref key, int value){
+      pairs.push_back(std::make_pair(std::string(key.begin(), key.end()), value));
+  }, ',', ':');
+
+  BOOST_CHECK(success);
+  BOOST_REQUIRE_EQUAL(pairs.size(), 2);
+  BOOST_CHECK_EQUAL(pairs[0].first, "a");
+  BOOST_CHECK_EQUAL(pairs[1].second, -2);
+}
+
+BOOST_AUTO_TEST_CASE(for_each_key_value_strings) {
+  const std::string str = "a = x ; b= y\t;c=;";
+  std::vector<std::pair<std::string, std::string>> pairs;
+
+  bool success = rapidxml::for_each_key_value<std::string>(str.data(), str.data() + str.size(),
+    [&](boost::string_ref key, const std::string& value){
+      pairs.push_back(std::make_pair(std::string(key.begin(), key.end()), value));
+  });
+
+  BOOST_CHECK(success);
+  BOOST_REQUIRE_EQUAL(pairs.size(), 3);
+  BOOST_CHECK_EQUAL(pairs[0].first, "a");
+  BOOST_CHECK_EQUAL(pairs[0].second, "x");
+  BOOST_CHECK_EQUAL(pairs[1].second, "y");
+  BOOST_CHECK_EQUAL(pairs[2].second, "");
+}
+
+BOOST_AUTO_TEST_CASE(for_each_key_value_benchmark) {
+  namespace qi = boost::spirit::qi;
+  namespace ascii = boost::spirit::ascii;
+  namespace ph = boost::phoenix;
+  typedef std::chrono::high_resolution_clock clock;
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  const size_t pair_count = 10000;
+  const size_t repeat = 20;
+  std::string str;
+  for (size_t i = 0; i < pair_count; ++i) {
+    str += "key" + std::to_string(i) + "=" + std::to_string(i) + ".25;";
+  }
+  const char* str_end = str.data() + str.size();
+
+  // qi rule summing the values, the cheapest use of a rule
+  double sum_rule = 0.0;
+  qi::rule<const char*> sum_rule_parser = *(qi::raw[+(qi::char_ - '=')] >> '=' >> qi::double_[ph::ref(sum_rule) += qi::_1] >> ';');
+  auto start = clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    const char* first = str.data();
+    qi::phrase_parse(first, str_end, sum_rule_parser, ascii::space);
+  }
+  auto sum_rule_time = clock::now() - start;
+
+  double sum_decoder = 0.0;
+  start = clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    rapidxml::for_each_key_value<double>(str.data(), str_end,
+      [&](boost::string_ref, double value){ sum_decoder += value; });
+  }
+  auto sum_decoder_time = clock::now() - start;
+
+  // qi rule filling a map, as special_map attributes are decoded today
+  std::map<std::string, double> map;
+  std::string key;
+  qi::rule<const char*> map_rule_parser = *(qi::as_string[+(qi::char_ - '=')][ph::ref(key) = qi::_1] >> '='
+    >> qi::double_[ph::ref(map)[ph::ref(key)] = qi::_1] >> ';');
+  start = clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    map.clear();
+    const char* first = str.data();
+    qi::phrase_parse(first, str_end, map_rule_parser, ascii::space);
+  }
+  auto map_rule_time = clock::now() - start;
+
+  std::vector<rapidxml::key_value<double>> storage(pair_count);
+  size_t count = 0;
+  start = clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    count = 0;
+    rapidxml::for_each_key_value<double>(str.data(), str_end, [&](boost::string_ref key, double value){
+      storage[count].key = key;
+      storage[count].value = value;
+      ++count;
+    });
+  }
+  auto storage_decoder_time = clock::now() - start;
+
+  BOOST_CHECK_EQUAL(sum_rule, sum_decoder);
+  BOOST_CHECK_EQUAL(map.size(), count);
+  BOOST_TEST_MESSAGE("key=value list of " << str.size() << " chars, " << repeat << " times."
+    << " sum - qi::rule: " << duration_cast<microseconds>(sum_rule_time).count() << " us"
+    << ", for_each_key_value: " << duration_cast<microseconds>(sum_decoder_time).count() << " us."
+    << " store - qi::rule to std::map: " << duration_cast<microseconds>(map_rule_time).count() << " us"
+    << ", for_each_key_value to key_value array: " << duration_cast<microseconds>(storage_decoder_time).count() << " us.");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
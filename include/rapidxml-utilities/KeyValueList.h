@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <boost/utility/string_ref.hpp>
+#include <rapidxml/rapidxml.hpp>
+#include "ValueConverter.h"
+
+namespace rapidxml {
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /// <summary> A decoded key=value pair. key points into the decoded attribute value. </summary>
+  ///
+  /// <typeparam name="T">  Type of the value. </typeparam>
+  /// <typeparam name="Ch"> Type of the character rapidxml doc uses. </typeparam>
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  template <typename T, typename Ch = char> struct key_value
+  {
+    boost::basic_string_ref<Ch> key;
+    T value;
+  };
+
+namespace detail {
+
+  // Calls a key=value lambda, lambdas returning bool stop the decoding by returning false.
+  template <typename ResultType> struct key_value_call
+  {
+    template <typename LambdaType, typename KeyType, typename T>
+    static bool call(LambdaType& fun, const KeyType& key, const T& value)
+    {
+      return fun(key, value) ? true : false;
+    }
+  };
+
+  template <> struct key_value_call<void>
+  {
+    template <typename LambdaType, typename KeyType, typename T>
+    static bool call(LambdaType& fun, const KeyType& key, const T& value) { fun(key, value); return true; }
+  };
+}
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /// <summary> Decodes a delimited key=value list, calling lambda for each pair. </summary>
+  ///
+  /// <remarks> Nothing is allocated, keys are references into the input. Spaces around keys and
+  ///           values, string values included, and empty items (e.g. a trailing pair separator)
+  ///           are ignored. Decoding stops at the first item without a key_separator, with an
+  ///           empty key or with a value that can not be converted to T. A lambda returning bool
+  ///           stops the decoding early by returning false. </remarks>
+  ///
+  /// <typeparam name="T">          Type of the values. </typeparam>
+  /// <typeparam name="Ch">         Type of the character. </typeparam>
+  /// <typeparam name="LambdaType"> Type of the lambda type. </typeparam>
+  /// <param name="first">          Start of the input. </param>
+  /// <param name="last">           End of the input. </param>
+  /// <param name="fun">            lambda called as fun(boost::basic_string_ref<Ch> key, const T& value),
+  ///                               returning void or bool. </param>
+  /// <param name="pair_separator"> Character between pairs. </param>
+  /// <param name="key_separator">  Character between a key and its value. </param>
+  ///
+  /// <returns> false if the input is malformed. </returns>
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  template <typename T, typename Ch, typename LambdaType> bool for_each_key_value
+    (const Ch* first, const Ch* last, LambdaType fun, Ch pair_separator = Ch(';'), Ch key_separator = Ch('='))
+  {
+    while (first != last) {
+      while (first != last && detail::is_value_space(*first)) ++first;
+      if (first == last) break;
+      if (*first == pair_separator) { ++first; continue; }
+
+      auto key_first = first;
+      while (first != last && *first != key_separator && *first != pair_separator) ++first;
+      if (first == last || *first == pair_separator || first == key_first) return false;
+      auto key_last = first;
+      while (detail::is_value_space(*(key_last - 1))) --key_last;
+
+      auto value_first = ++first;
+      while (first != last && *first != pair_separator) ++first;
+      auto value_last = first;
+      while (value_first != value_last && detail::is_value_space(*value_first)) ++value_first;
+      while (value_last != value_first && detail::is_value_space(*(value_last - 1))) --value_last;
+
+      T value;
+      if (! detail::value_converter<T>::convert(value_first, value_last, value)) return false;
+      boost::basic_string_ref<Ch> key(key_first, key_last - key_first);
+      if (! detail::key_value_call<decltype(fun(key, value))>::call(fun, key, value)) break;
+      if (first != last) ++first;
+    }
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /// <summary> Decodes a delimited key=value list attribute, calling lambda for each pair. </summary>
+  ///
+  /// <typeparam name="T">          Type of the values. </typeparam>
+  /// <typeparam name="NodeType">   Type of the node type. </typeparam>
+  /// <typeparam name="Ch">         Type of the character rapidxml doc uses. </typeparam>
+  /// <typeparam name="LambdaType"> Type of the lambda type. </typeparam>
+  /// <param name="node">           [in,out] If non-null, the node. </param>
+  /// <param name="attr_name">      Name of the attribute. </param>
+  /// <param name="fun">            lambda called as fun(boost::basic_string_ref<Ch> key, const T& value),
+  ///                               returning void or bool. </param>
+  /// <param name="pair_separator"> Character between pairs. </param>
+  /// <param name="key_separator">  Character between a key and its value. </param>
+  ///
+  /// <returns> false if the node or attribute does not exist or the value is malformed. </returns>
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  template <typename T, typename NodeType, typename Ch, typename LambdaType> bool attribute_for_each_key_value
+    (NodeType* node, const Ch* attr_name, LambdaType fun, Ch pair_separator = Ch(';'), Ch key_separator = Ch('='))
+  {
+    if (! node) return false;
+    auto attribute = node->first_attribute(attr_name);
+    if (! attribute) return false;
+
+    return for_each_key_value<T>(attribute->value(), attribute->value() + attribute->value_size(),
+      fun, pair_separator, key_separator);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  /// <summary> Decodes a delimited key=value list attribute into caller provided storage. Throws
+  ///           error if decoding fails or the storage is too small. </summary>
+  ///
+  /// <remarks> Decoding stops at the first pair that does not fit. </remarks>
+  ///
+  /// <typeparam name="T">        Type of the values. </typeparam>
+  /// <typeparam name="NodeType"> Type of the node type. </typeparam>
+  /// <typeparam name="Ch">       Type of the character rapidxml doc uses. </typeparam>
+  /// <param name="node">           [in,out] If non-null, the node. </param>
+  /// <param name="attr_name">      Name of the attribute. </param>
+  /// <param name="out">            [out] Storage for the decoded pairs, in attribute order. </param>
+  /// <param name="capacity">       Number of pairs out can hold. </param>
+  /// <param name="pair_separator"> Character between pairs. </param>
+  /// <param name="key_separator">  Character between a key and its value. </param>
+  ///
+  /// <returns> Number of pairs decoded. </returns>
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+  template <typename T, typename NodeType, typename Ch> std::size_t attribute_key_values
+    (NodeType* node, const Ch* attr_name, key_value<T, Ch>* out, std::size_t capacity,
+    Ch pair_separator = Ch(';'), Ch key_separator = Ch('='))
+  {
+    if (! node) throw std::runtime_error("node does not exists.");
+    auto attribute = node->first_attribute(attr_name);
+    if (! attribute) throw std::runtime_error("attribute does not exists.");
+
+    std::size_t count = 0;
+    bool overflow = false;
+    bool success = for_each_key_value<T>(attribute->value(), attribute->value() + attribute->value_size(),
+      [&](boost::basic_string_ref<Ch> key, const T& value) -> bool {
+        if (count == capacity) { overflow = true; return false; }
+        out[count].key = key;
+        out[count].value = value;
+        ++count;
+        return true;
+      }, pair_separator, key_separator);
+
+    if (! success) throw std::runtime_error("cast failed.");
+    if (overflow) throw std::runtime_error("not enough storage.");
+    return count;
+  }
+
+}
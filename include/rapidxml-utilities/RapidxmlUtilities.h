@@ -129,7 +129,7 @@ namespace detail {
     if (! attribute) {on_error(); return;};
 
     detail::parse_string(attribute->value(), rule);
-    if (detail::parse_error) on_error;
+    if (detail::parse_error) on_error();
   }
 
   //template <typename VectorType, typename NodeType, typename Ch, typename SeperatorType> void attribute_cast_pushback(
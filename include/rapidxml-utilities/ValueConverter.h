@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <boost/spirit/include/qi.hpp>
+#include <boost/utility/string_ref.hpp>
+
+namespace rapidxml {
+
+namespace detail {
+
+  template <typename Ch> bool is_value_space(Ch ch)
+  {
+    return ch == Ch(' ') || ch == Ch('\t') || ch == Ch('\n') || ch == Ch('\r') || ch == Ch('\v') || ch == Ch('\f');
+  }
+
+  // Converts the character range [first, last) to a value. Surrounding spaces are allowed,
+  // anything else left unparsed is an error. Spaces are trimmed by hand instead of using a
+  // skipper, which keeps the parser call on the fast qi::parse path.
+  template <typename Ch, typename ParserType, typename T> bool parse_value
+    (const Ch* first, const Ch* last, const ParserType& parser, T& out)
+  {
+    namespace qi = boost::spirit::qi;
+
+    while (first != last && is_value_space(*first)) ++first;
+    while (last != first && is_value_space(*(last - 1))) --last;
+    return qi::parse(first, last, parser, out) && first == last;
+  }
+
+  template <typename T> struct value_converter {};
+  template <> struct value_converter<double> {
+    template <typename Ch> static bool convert(const Ch* first, const Ch* last, double& out)
+    { return parse_value(first, last, boost::spirit::qi::double_, out); }
+  };
+  template <> struct value_converter<float> {
+    template <typename Ch> static bool convert(const Ch* first, const Ch* last, float& out)
+    { return parse_value(first, last, boost::spirit::qi::float_, out); }
+  };
+  template <> struct value_converter<int> {
+    template <typename Ch> static bool convert(const Ch* first, const Ch* last, int& out)
+    { return parse_value(first, last, boost::spirit::qi::int_, out); }
+  };
+  template <> struct value_converter<unsigned> {
+    template <typename Ch> static bool convert(const Ch* first, const Ch* last, unsigned& out)
+    { return parse_value(first, last, boost::spirit::qi::uint_, out); }
+  };
+  template <> struct value_converter<unsigned long long> {
+    template <typename Ch> static bool convert(const Ch* first, const Ch* last, unsigned long long& out)
+    { return parse_value(first, last, boost::spirit::qi::ulong_long, out); }
+  };
+  template <> struct value_converter<unsigned long> {
+    template <typename Ch> static bool convert(const Ch* first, const Ch* last, unsigned long& out)
+    { return parse_value(first, last, boost::spirit::qi::ulong_, out); }
+  };
+  template <typename C, typename Traits, typename Alloc> struct value_converter<std::basic_string<C, Traits, Alloc>> {
+    template <typename Ch> static bool convert(const Ch* first, const Ch* last, std::basic_string<C, Traits, Alloc>& out)
+    { out.assign(first, last); return true; }
+  };
+  template <typename C, typename Traits> struct value_converter<boost::basic_string_ref<C, Traits>> {
+    template <typename Ch> static bool convert(const Ch* first, const Ch* last, boost::basic_string_ref<C, Traits>& out)
+    { out = boost::basic_string_ref<C, Traits>(first, last - first); return true; }
+  };
+}
+
+}